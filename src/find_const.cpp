@@ -37,20 +37,230 @@
 #include <SwitchPolicySingleEvent.hpp>
 #include <WhilePolicySingleEvent.hpp>
 
+#include <charconv>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <find_const.hpp>
+#include <fstream>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <vector>
 
+// Quotes an argument for /bin/sh so it reaches the command as one word
+std::string shellQuote(const std::string &arg) {
+  std::string quoted = "'";
+  for (char c : arg) {
+    if (c == '\'') {
+      quoted += "'\\''";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "'";
+}
+
+// Parses a non-negative decimal number, rejecting trailing garbage
+bool parseCount(const char *text, std::size_t &value) {
+  const char *end = text + std::strlen(text);
+  auto [last, error] = std::from_chars(text, end, value);
+  return error == std::errc() && last == end && last != text;
+}
+
+void usage() {
+  std::cerr << "Usage: find_const [options] input_file.cpp\n"
+            << "  --diff <file.diff>    only analyze code changed in a "
+               "unified diff\n"
+            << "  --git <rev1> <rev2>   only analyze code changed between two "
+               "git revisions\n"
+            << "  --time-budget <ms>    skip a unit whose analysis takes "
+               "longer\n"
+            << "  --memory-budget <MB>  skip a unit whose analysis needs "
+               "more memory\n"
+            << "  --baseline <file>     only report candidates missing from "
+               "a baseline\n"
+            << "  --write-baseline <file>  write a baseline of all "
+               "candidates\n"
+            << "  --shard <i>/<N>       only analyze the units of shard i "
+               "out of N\n"
+            << "  --emit <file>         write structured results for "
+               "--merge\n"
+            << "Usage: find_const [--baseline <file>] --merge <file>...\n"
+            << "  combine the --emit results of all shards\n";
+  exit(1);
+}
+
+// Command line settings for one analysis run
+struct Options {
+  std::optional<DiffScope> scope;
+  std::chrono::milliseconds timeBudget{0};
+  std::size_t memoryBudget = 0;
+  std::stringstream baselineText;
+  bool hasBaseline = false;
+  std::string writeBaselineFile;
+  std::string emitFile;
+  std::size_t shardIndex = 0;
+  std::size_t shardCount = 1;
+};
+
+// Parses one srcML file, prints the report and writes the requested files
+void analyze(const char *xmlPath, Options &options) {
+  try {
+    srcSAXController control(xmlPath);
+    collector result;
+    if (options.scope) {
+      result.setDiffScope(*options.scope);
+    }
+    result.setBudget(options.timeBudget, options.memoryBudget);
+    result.setShard(options.shardIndex, options.shardCount);
+    result.setSourceRoot(std::filesystem::current_path());
+    if (options.hasBaseline) {
+      result.loadBaseline(options.baselineText);
+    }
+    srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&result);
+    control.parse(&dispatch); // Start parsing
+    result.printConst();
+    if (!options.writeBaselineFile.empty()) {
+      std::ofstream baseline(options.writeBaselineFile);
+      if (!baseline) {
+        std::cerr << "Error: cannot write baseline "
+                  << options.writeBaselineFile << std::endl;
+        exit(1);
+      }
+      result.writeBaseline(baseline);
+    }
+    if (!options.emitFile.empty()) {
+      std::ofstream emitted(options.emitFile);
+      if (emitted) {
+        result.emit(emitted);
+        emitted.flush();
+      }
+      if (!emitted) {
+        std::cerr << "Error: cannot write emit file " << options.emitFile
+                  << std::endl;
+        exit(1);
+      }
+    }
+  } catch (SAXError error) {
+    std::cerr << error.message << std::endl;
+  } catch (const std::string &e) {
+    std::cerr << "String exception: " << e << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Standard exception: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "Unknown exception occurred" << std::endl;
+  }
+}
+
 int main(int argc, char *argv[]) {
-  if (argc < 2) {
-    std::cerr << "Usage: find_const input_file.cpp\n";
-    exit(1);
+  Options options;
+  int arg = 1;
+  // The last option --merge would ignore, so it can be rejected
+  std::string analysisOption;
+  for (; arg < argc && std::string(argv[arg]).rfind("--", 0) == 0; ++arg) {
+    const std::string option = argv[arg];
+    if (option != "--baseline" && option != "--merge") {
+      analysisOption = option;
+    }
+    if (option == "--diff" && arg + 1 < argc) {
+      std::ifstream diff(argv[++arg]);
+      if (!diff) {
+        std::cerr << "Error: cannot read diff " << argv[arg] << std::endl;
+        exit(1);
+      }
+      options.scope.emplace();
+      options.scope->parseUnifiedDiff(diff);
+    } else if (option == "--git" && arg + 2 < argc) {
+      // --end-of-options keeps a revision starting with '-' from being read
+      // as an option; the trailing -- keeps it from being read as a path
+      std::string command = "git diff -U0 --end-of-options " +
+                            shellQuote(argv[arg + 1]) + " " +
+                            shellQuote(argv[arg + 2]) + " --";
+      arg += 2;
+      FILE *pipe = popen(command.c_str(), "r");
+      if (!pipe) {
+        std::cerr << "Error executing git diff command." << std::endl;
+        exit(1);
+      }
+      std::string diffText;
+      char buffer[4096];
+      std::size_t bytes;
+      while ((bytes = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        diffText.append(buffer, bytes);
+      }
+      if (pclose(pipe) != 0) {
+        std::cerr << "Error executing git diff command." << std::endl;
+        exit(1);
+      }
+      std::istringstream diff(diffText);
+      options.scope.emplace();
+      options.scope->parseUnifiedDiff(diff);
+    } else if (option == "--time-budget" && arg + 1 < argc) {
+      std::size_t milliseconds = 0;
+      if (!parseCount(argv[++arg], milliseconds)) {
+        usage();
+      }
+      options.timeBudget = std::chrono::milliseconds(milliseconds);
+    } else if (option == "--memory-budget" && arg + 1 < argc) {
+      std::size_t megabytes = 0;
+      if (!parseCount(argv[++arg], megabytes)) {
+        usage();
+      }
+      options.memoryBudget = megabytes * 1024 * 1024;
+    } else if (option == "--baseline" && arg + 1 < argc) {
+      std::ifstream baseline(argv[++arg]);
+      if (!baseline) {
+        std::cerr << "Error: cannot read baseline " << argv[arg] << std::endl;
+        exit(1);
+      }
+      options.baselineText << baseline.rdbuf();
+      options.hasBaseline = true;
+    } else if (option == "--write-baseline" && arg + 1 < argc) {
+      options.writeBaselineFile = argv[++arg];
+    } else if (option == "--shard" && arg + 1 < argc) {
+      const std::string shard = argv[++arg];
+      std::size_t slash = shard.find('/');
+      if (slash == std::string::npos ||
+          !parseCount(shard.substr(0, slash).c_str(), options.shardIndex) ||
+          !parseCount(shard.substr(slash + 1).c_str(), options.shardCount) ||
+          options.shardCount == 0 ||
+          options.shardIndex >= options.shardCount) {
+        usage();
+      }
+    } else if (option == "--emit" && arg + 1 < argc) {
+      options.emitFile = argv[++arg];
+    } else if (option == "--merge" && arg + 1 < argc) {
+      if (!analysisOption.empty()) {
+        std::cerr << "Error: --merge does not take " << analysisOption
+                  << std::endl;
+        exit(1);
+      }
+      ShardMerger merger;
+      if (options.hasBaseline) {
+        merger.loadBaseline(options.baselineText);
+      }
+      for (++arg; arg < argc; ++arg) {
+        std::ifstream shard(argv[arg]);
+        if (!shard) {
+          std::cerr << "Error: cannot read shard " << argv[arg] << std::endl;
+          exit(1);
+        }
+        merger.add(shard);
+      }
+      merger.print(std::cout);
+      return 0;
+    } else {
+      usage();
+    }
+  }
+
+  if (arg >= argc) {
+    usage();
   }
 
-  const std::string &filename = std::string(argv[1]);
+  const std::string &filename = std::string(argv[arg]);
 
   if (filename.find(".cpp") != std::string::npos) {
     std::string command = "srcml --position " + filename + " -o input.xml";
@@ -65,41 +275,19 @@ int main(int argc, char *argv[]) {
       exit(1);
     }
 
-    try {
-      srcSAXController control("input.xml");
-      collector result;
-      srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&result);
-      control.parse(&dispatch); // Start parsing
-      result.printConst();
-
-      // Fix: Properly declare the remove result variable
-      int removeResult = remove("input.xml");
-
-      // Check if deletion was successful
-      if (removeResult == 0) {
-        printf("File deleted successfully\n");
-      } else {
-        perror("Error deleting file");
-      }
-    } catch (SAXError error) {
-      std::cerr << error.message;
+    analyze("input.xml", options);
+
+    // Fix: Properly declare the remove result variable
+    int removeResult = remove("input.xml");
+
+    // Check if deletion was successful
+    if (removeResult == 0) {
+      printf("File deleted successfully\n");
+    } else {
+      perror("Error deleting file");
     }
   } else {
-    try {
-      srcSAXController control(argv[1]);
-      collector result;
-      srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&result);
-      control.parse(&dispatch); // Start parsing
-      result.printConst();
-    } catch (SAXError error) {
-      std::cerr << error.message << std::endl;
-    } catch (const std::string &e) {
-      std::cerr << "String exception: " << e << std::endl;
-    } catch (const std::exception &e) {
-      std::cerr << "Standard exception: " << e.what() << std::endl;
-    } catch (...) {
-      std::cerr << "Unknown exception occurred" << std::endl;
-    }
+    analyze(argv[arg], options);
   }
 
   return 0;
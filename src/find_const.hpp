@@ -16,20 +16,201 @@
 #include <SwitchPolicySingleEvent.hpp>
 #include <WhilePolicySingleEvent.hpp>
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
 #include <filesystem>
+#include <map>
+#include <memory_resource>
+#include <optional>
 #include <set>
 #include <sstream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
 #include <vector>
 
+// Typed views of the std::any nodes srcDispatch produces. BodyLinearizer
+// converts each node once with fromAny; later passes dispatch with
+// std::visit and never look at the std::any again.
+using ConditionalNode =
+    std::variant<std::shared_ptr<IfStmtData>, std::shared_ptr<SwitchData>,
+                 std::shared_ptr<WhileData>, std::shared_ptr<ForData>,
+                 std::shared_ptr<DoData>>;
+using ClauseNode =
+    std::variant<std::shared_ptr<IfData>, std::shared_ptr<ElseIfData>,
+                 std::shared_ptr<ElseData>>;
+using ExprNode =
+    std::variant<std::monostate, std::shared_ptr<NameData>,
+                 std::shared_ptr<OperatorData>, std::shared_ptr<LiteralData>,
+                 std::shared_ptr<CallData>>;
+
+// Stores the alternative held by value in node. Returns false if value holds
+// none of the variant's alternatives. The alternative is found with a single
+// value.type() lookup rather than trying each type in turn.
+template <typename... Ts>
+bool fromAny(const std::any &value, std::variant<Ts...> &node) {
+  using Converter = void (*)(const std::any &, std::variant<Ts...> &);
+  static const std::unordered_map<std::type_index, Converter> converters = {
+      {std::type_index(typeid(Ts)),
+       +[](const std::any &from, std::variant<Ts...> &to) {
+         to = *std::any_cast<Ts>(&from);
+       }}...};
+  auto converter = converters.find(std::type_index(value.type()));
+  if (converter == converters.end()) {
+    return false;
+  }
+  converter->second(value, node);
+  return true;
+}
+
+struct BudgetExceeded : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+// Time and memory spent analyzing one unit (source file). A limit of zero
+// means unlimited. Memory counts what the collector's unit arena holds, not
+// the parsed srcML tree.
+struct AnalysisBudget {
+  std::chrono::milliseconds timeLimit{0};
+  std::size_t memoryLimit = 0;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  std::size_t bytes = 0;
+  std::size_t peakBytes = 0;
+  std::size_t functions = 0;
+
+  void startUnit() {
+    start = std::chrono::steady_clock::now();
+    peakBytes = bytes;
+    functions = 0;
+  }
+
+  long long elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  // A charge that does not fit is not kept, but still shows in peakBytes
+  void charge(std::size_t size) {
+    peakBytes = std::max(peakBytes, bytes + size);
+    if (memoryLimit > 0 && bytes + size > memoryLimit) {
+      throw BudgetExceeded("memory budget exceeded");
+    }
+    bytes += size;
+  }
+
+  void release(std::size_t size) { bytes -= std::min(bytes, size); }
+
+  // Memory outside the arena (e.g. a stack buffer), charged while it lives
+  struct Hold {
+    AnalysisBudget &budget;
+    std::size_t size;
+    Hold(AnalysisBudget &budget, std::size_t size)
+        : budget(budget), size(size) {
+      budget.charge(size);
+    }
+    ~Hold() { budget.release(size); }
+  };
+
+  // Reading the clock on every node is measurable, so sample it
+  void tick() {
+    if (timeLimit.count() > 0 && ++ticks % 256 == 0) {
+      check();
+    }
+  }
+
+  void check() const {
+    if (timeLimit.count() > 0 &&
+        std::chrono::steady_clock::now() - start > timeLimit) {
+      throw BudgetExceeded("time budget exceeded");
+    }
+  }
+
+private:
+  std::size_t ticks = 0;
+};
+
+// Upstream of the collector's unit arena. Charges the budget for every block
+// the arena takes from the system and releases it when the block goes back.
+class BudgetedResource : public std::pmr::memory_resource {
+public:
+  explicit BudgetedResource(AnalysisBudget &budget) : budget(budget) {}
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    budget.charge(bytes);
+    try {
+      return upstream->allocate(bytes, alignment);
+    } catch (...) {
+      budget.release(bytes);
+      throw;
+    }
+  }
+
+  void do_deallocate(void *block, std::size_t bytes,
+                     std::size_t alignment) override {
+    upstream->deallocate(block, bytes, alignment);
+    budget.release(bytes);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  AnalysisBudget &budget;
+  std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+};
+
 struct BodyLinearizer {
-  std::vector<std::shared_ptr<DeclData>> locals;
-  std::vector<std::shared_ptr<ExpressionData>> returns;
-  std::vector<std::shared_ptr<ExpressionData>> expr_stmts;
-  std::vector<std::any> conditionals;
+  std::pmr::vector<std::shared_ptr<DeclData>> locals;
+  std::pmr::vector<std::shared_ptr<ExpressionData>> returns;
+  std::pmr::vector<std::shared_ptr<ExpressionData>> expr_stmts;
+  std::pmr::vector<ConditionalNode> conditionals;
+  // Parts of expr_stmts[pos] that the analysis reads, converted once
+  std::pmr::vector<ExprNode> expr_parts;
+  std::pmr::vector<std::size_t> expr_begin;
+
+  // Optional: its time limit is checked while linearizing
+  AnalysisBudget *budget = nullptr;
+
+  // Bodies nested deeper than this are abandoned before the recursion can
+  // overflow the stack (256 is the nesting the standard asks compilers to
+  // support)
+  static constexpr std::size_t maxDepth = 256;
+  std::size_t depth = 0;
+
+  BodyLinearizer() {}
+  BodyLinearizer(AnalysisBudget *budget) : budget(budget) {}
+  // Lists are allocated from resource, e.g. the collector's unit arena
+  BodyLinearizer(AnalysisBudget *budget, std::pmr::memory_resource *resource)
+      : locals(resource), returns(resource), expr_stmts(resource),
+        conditionals(resource), expr_parts(resource), expr_begin(resource),
+        budget(budget) {}
 
   void linearizeBody(const std::shared_ptr<BlockData> &body) {
     if (!body)
       return;
+    if (++depth > maxDepth) {
+      throw BudgetExceeded("nesting depth budget exceeded");
+    }
+
+    if (budget)
+      budget->tick();
 
     for (std::size_t pos = 0; pos < body->locals.size(); ++pos) {
       locals.push_back(body->locals[pos]);
@@ -39,48 +220,51 @@ struct BodyLinearizer {
     }
     for (std::size_t pos = 0; pos < body->expr_stmts.size(); ++pos) {
       expr_stmts.push_back(body->expr_stmts[pos]);
-    }
-    for (std::size_t pos = 0; pos < body->conditionals.size(); ++pos) {
-      conditionals.push_back(body->conditionals[pos]);
-      if (conditionals.back().type() == typeid(std::shared_ptr<IfStmtData>)) {
-        std::shared_ptr<IfStmtData> if_stmt =
-            std::any_cast<std::shared_ptr<IfStmtData>>(conditionals.back());
-        for (std::any clause : if_stmt->clauses) {
-          if (clause.type() == typeid(std::shared_ptr<IfData>)) {
-            linearizeBody(
-                std::any_cast<std::shared_ptr<IfData>>(clause)->block);
-          } else if (clause.type() == typeid(std::shared_ptr<ElseIfData>)) {
-            linearizeBody(
-                std::any_cast<std::shared_ptr<ElseIfData>>(clause)->block);
-          } else if (clause.type() == typeid(std::shared_ptr<ElseData>)) {
-            linearizeBody(
-                std::any_cast<std::shared_ptr<ElseData>>(clause)->block);
-          }
+      expr_begin.push_back(expr_parts.size());
+      if (!body->expr_stmts[pos])
+        continue;
+      for (const std::any &part : body->expr_stmts[pos]->expr) {
+        ExprNode node;
+        if (fromAny(part, node)) {
+          expr_parts.push_back(node);
         }
-      } else if (conditionals.back().type() ==
-                 typeid(std::shared_ptr<SwitchData>)) {
-        linearizeBody(
-            std::any_cast<std::shared_ptr<SwitchData>>(conditionals.back())
-                ->block);
-      } else if (conditionals.back().type() ==
-                 typeid(std::shared_ptr<WhileData>)) {
-        linearizeBody(
-            std::any_cast<std::shared_ptr<WhileData>>(conditionals.back())
-                ->block);
-      } else if (conditionals.back().type() ==
-                 typeid(std::shared_ptr<ForData>)) {
-        linearizeBody(
-            std::any_cast<std::shared_ptr<ForData>>(conditionals.back())
-                ->block);
-      } else if (conditionals.back().type() ==
-                 typeid(std::shared_ptr<DoData>)) {
-        linearizeBody(
-            std::any_cast<std::shared_ptr<DoData>>(conditionals.back())->block);
       }
     }
+    for (std::size_t pos = 0; pos < body->conditionals.size(); ++pos) {
+      ConditionalNode conditional;
+      if (!fromAny(body->conditionals[pos], conditional))
+        continue;
+      conditionals.push_back(conditional);
+      std::visit([this](const auto &data) { linearizeConditional(data); },
+                 conditional);
+    }
     for (std::size_t pos = 0; pos < body->blocks.size(); ++pos) {
       linearizeBody(body->blocks[pos]);
     }
+    --depth;
+  }
+
+  // Converted parts of expr_stmts[pos]
+  std::span<const ExprNode> exprParts(std::size_t pos) const {
+    std::size_t end =
+        pos + 1 < expr_begin.size() ? expr_begin[pos + 1] : expr_parts.size();
+    return {expr_parts.data() + expr_begin[pos], end - expr_begin[pos]};
+  }
+
+private:
+  void linearizeConditional(const std::shared_ptr<IfStmtData> &if_stmt) {
+    for (const std::any &clause : if_stmt->clauses) {
+      ClauseNode node;
+      if (fromAny(clause, node)) {
+        std::visit([this](const auto &data) { linearizeBody(data->block); },
+                   node);
+      }
+    }
+  }
+
+  template <typename Conditional>
+  void linearizeConditional(const std::shared_ptr<Conditional> &data) {
+    linearizeBody(data->block);
   }
 };
 
@@ -91,25 +275,145 @@ std::string join(const std::vector<std::string> &string_vec) {
   return joined_stream.str();
 }
 
+// 64-bit FNV-1a, stable across runs and platforms (unlike std::hash)
+std::uint64_t fingerprint(const std::string &text) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// A fingerprint as written to baselines and emit() records
+std::string formatFingerprint(std::uint64_t print) {
+  std::ostringstream text;
+  text << std::hex << std::setw(16) << std::setfill('0') << print;
+  return text.str();
+}
+
+// Reads a 64-bit hexadecimal fingerprint with nothing else around it
+bool parseFingerprint(const std::string &text, std::uint64_t &print) {
+  const char *end = text.data() + text.size();
+  auto [last, error] = std::from_chars(text.data(), end, print, 16);
+  return error == std::errc() && last == end && text.size() <= 16;
+}
+
+// Baseline: sorted fingerprints, one hexadecimal value per line.
+// Lines that are not a 64-bit hexadecimal value are reported and skipped
+void readBaseline(std::istream &in,
+                  std::unordered_set<std::uint64_t> &baseline) {
+  std::string line;
+  std::size_t lineNumber = 0;
+  while (std::getline(in, line)) {
+    ++lineNumber;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.empty())
+      continue;
+    std::uint64_t print = 0;
+    if (!parseFingerprint(line, print)) {
+      std::cerr << "Warning: ignoring malformed baseline line " << lineNumber
+                << ": " << line << std::endl;
+      continue;
+    }
+    baseline.insert(print);
+  }
+}
+
+// Changed line ranges (new side) per file, read from a unified diff
+struct DiffScope {
+  std::map<std::string, std::vector<std::pair<unsigned int, unsigned int>>>
+      hunks;
+
+  void parseUnifiedDiff(std::istream &diff) {
+    std::string line;
+    std::string current;
+    while (std::getline(diff, line)) {
+      if (line.rfind("+++ ", 0) == 0) {
+        current = line.substr(4, line.find('\t') - 4);
+        if (current == "/dev/null") {
+          current.clear();
+        } else if (current.rfind("b/", 0) == 0) {
+          current = current.substr(2);
+        }
+      } else if (line.rfind("@@ ", 0) == 0 && !current.empty()) {
+        // @@ -a,b +c,d @@: the new side starts at c and spans d lines
+        std::size_t plus = line.find(" +");
+        if (plus == std::string::npos)
+          continue;
+        unsigned int start = 0;
+        unsigned int count = 1;
+        if (std::sscanf(line.c_str() + plus + 2, "%u,%u", &start, &count) <
+            1)
+          continue;
+        // A pure deletion still touches the code around line c
+        unsigned int first = start > 0 ? start : 1;
+        unsigned int last = count > 0 ? start + count - 1 : first;
+        hunks[current].push_back({first, last});
+      }
+    }
+  }
+
+  bool overlaps(const std::string &filename, unsigned int first,
+                unsigned int last) const {
+    for (const auto &[path, ranges] : hunks) {
+      if (!samePath(path, filename))
+        continue;
+      for (const auto &[hunkFirst, hunkLast] : ranges) {
+        if (hunkFirst <= last && first <= hunkLast)
+          return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  // Diff paths are repository relative, srcML filenames may not be
+  static bool samePath(const std::string &a, const std::string &b) {
+    auto endsWith = [](const std::string &str, const std::string &suffix) {
+      return str.size() > suffix.size() &&
+             str.compare(str.size() - suffix.size(), suffix.size(), suffix) ==
+                 0 &&
+             str[str.size() - suffix.size() - 1] == '/';
+    };
+    return a == b || endsWith(a, b) || endsWith(b, a);
+  }
+};
+
 class collector : public srcDispatch::PolicyListener {
 public:
   collector() {}
   ~collector() {}
   void Notify(const srcDispatch::PolicyDispatcher *policy,
               const srcDispatch::srcSAXEventContext &ctx) override {
-    // Save class and function information
+    // Save class, function and global information. Units owned by another
+    // shard are dropped here so they are never retained. Definitions from a
+    // header shared by several units are only kept the first time.
+    if (!ownsUnit(ctx.currentFilePath)) {
+      return;
+    }
     if (typeid(ClassPolicy) == typeid(*policy)) {
       std::shared_ptr<ClassData> class_data = policy->Data<ClassData>();
-      classInfo.push_back(class_data);
+      if (firstSeen(class_data->filename, classSubtree(class_data))) {
+        classInfo.push_back(class_data);
+      }
     } else if (typeid(FunctionPolicy) == typeid(*policy)) {
       std::shared_ptr<FunctionData> function_data =
           policy->Data<FunctionData>();
-      functionInfo.push_back(function_data);
+      if (firstSeen(function_data->filename,
+                    functionSubtree(function_data))) {
+        functionInfo.push_back(function_data);
+      }
     } else if (typeid(DeclTypePolicy) == typeid(*policy)) {
       std::shared_ptr<std::vector<std::shared_ptr<DeclData>>> decls =
           policy->Data<std::vector<std::shared_ptr<DeclData>>>();
       for (const std::shared_ptr<DeclData> &decl : *decls) {
+        if (!firstSeen(ctx.currentFilePath, declSubtree(decl)))
+          continue;
         declInfo.push_back(decl);
+        candidateScopes[decl.get()] = {ctx.currentFilePath, ""};
       }
     }
   }
@@ -209,37 +513,11 @@ public:
       std::cout << "  Conditionals: " << linearizer.conditionals.size()
                 << std::endl;
       for (std::size_t pos = 0; pos < linearizer.conditionals.size(); ++pos) {
-        if (linearizer.conditionals[pos].type() ==
-            typeid(std::shared_ptr<IfStmtData>)) {
-          std::cout << "   "
-                    << *(std::any_cast<std::shared_ptr<IfStmtData>>(
-                           linearizer.conditionals[pos]))
-                    << std::endl;
-        } else if (linearizer.conditionals[pos].type() ==
-                   typeid(std::shared_ptr<SwitchData>)) {
-          std::cout << "   "
-                    << *(std::any_cast<std::shared_ptr<SwitchData>>(
-                           linearizer.conditionals[pos]))
-                    << std::endl;
-        } else if (linearizer.conditionals[pos].type() ==
-                   typeid(std::shared_ptr<WhileData>)) {
-          std::cout << "   "
-                    << *(std::any_cast<std::shared_ptr<WhileData>>(
-                           linearizer.conditionals[pos]))
-                    << std::endl;
-        } else if (linearizer.conditionals[pos].type() ==
-                   typeid(std::shared_ptr<ForData>)) {
-          std::cout << "   "
-                    << *(std::any_cast<std::shared_ptr<ForData>>(
-                           linearizer.conditionals[pos]))
-                    << std::endl;
-        } else if (linearizer.conditionals[pos].type() ==
-                   typeid(std::shared_ptr<DoData>)) {
-          std::cout << "   "
-                    << *(std::any_cast<std::shared_ptr<DoData>>(
-                           linearizer.conditionals[pos]))
-                    << std::endl;
-        }
+        std::visit(
+            [](const auto &data) {
+              std::cout << "   " << *data << std::endl;
+            },
+            linearizer.conditionals[pos]);
       }
       std::cout << std::endl;
     }
@@ -257,9 +535,28 @@ public:
       fileName = name;
   }
 
+  struct SkippedUnit {
+    std::string filename;
+    std::string reason;
+    long long elapsedMs;
+    std::size_t peakBytes;
+    std::size_t functions;
+  };
+
+  void setBudget(std::chrono::milliseconds timeLimit,
+                 std::size_t memoryLimit) {
+    budget.timeLimit = timeLimit;
+    budget.memoryLimit = memoryLimit;
+  }
+
+  // Restrict analysis to classes/functions overlapping changed lines
+  void setDiffScope(const DiffScope &scope) { diffScope = scope; }
+
   void processConst() {
+    // Global candidates depend on every body in the unit, so they cannot be
+    // decided from a diff-scoped run
     for (std::shared_ptr<DeclData> decl : declInfo) {
-      if (decl && decl->init->expr.size() > 0) {
+      if (!diffScope && decl && decl->init->expr.size() > 0) {
         std::string type = decl->type->ToString();
         if (type.find("const") == std::string::npos &&
             type.find("constexpr") == std::string::npos) {
@@ -268,16 +565,8 @@ public:
       }
     }
 
-    for (std::shared_ptr<ClassData> classData : classInfo) {
-      assignFileName(classData->filename);
-      ConstInClass(classData);
-    }
-
-    for (std::shared_ptr<FunctionData> funcData : functionInfo) {
-      assignFileName(funcData->filename);
-      std::vector<std::shared_ptr<DeclData>> empty;
-      // std::cout << *(funcData->name) << std::endl;
-      ConstInFunction(funcData, empty, false);
+    for (const UnitWork &unit : groupByUnit()) {
+      processUnit(unit);
     }
   }
 
@@ -286,39 +575,84 @@ public:
     std::cout << "Variable const candidates:" << std::endl;
     std::cout << "Global variable const candidates:" << std::endl;
     for (std::shared_ptr<DeclData> decl : globConInfo) {
-      std::cout << fileName << ":" << decl->lineNumber << ":"
-                << decl->type->ToString() << " " << decl->name->ToString()
-                << " = " << *(decl->init) << ";" << std::endl;
+      if (suppressed(declFingerprint("global", decl)))
+        continue;
+      std::cout << formatDecl(scopeOf(decl.get()).filename, decl)
+                << std::endl;
     }
     std::cout << "\nFunction variable const candidates:" << std::endl;
     for (std::shared_ptr<DeclData> decl : varConInfo) {
-      std::cout << fileName << ":" << decl->lineNumber << ":"
-                << decl->type->ToString() << " " << decl->name->ToString()
-                << " = " << *(decl->init) << ";" << std::endl;
+      if (suppressed(declFingerprint("variable", decl)))
+        continue;
+      std::cout << formatDecl(scopeOf(decl.get()).filename, decl)
+                << std::endl;
     }
     std::cout << "\nFunction const candidates:" << std::endl;
     for (std::shared_ptr<FunctionData> func : funConInfo) {
-      std::cout << fileName << ":" << func->lineNumber << ":"
-                << func->returnType->ToString() << " " << func->name->ToString()
-                << "(";
-      for (std::size_t pos = 0; pos < func->parameters.size(); ++pos) {
-        if (pos > 0) {
-          std::cout << ", ";
-        }
-        std::cout << func->parameters[pos]->type->ToString() << " "
-                  << func->parameters[pos]->name->ToString();
+      if (suppressed(functionFingerprint(func)))
+        continue;
+      std::cout << formatFunction(scopeOf(func.get()).filename, func)
+                << std::endl;
+    }
+    if (!baseline.empty()) {
+      std::cout << "\nSuppressed by baseline: " << suppressedCount
+                << std::endl;
+    }
+    if (!skippedUnits.empty()) {
+      std::cout << "\nSkipped units:" << std::endl;
+      for (const SkippedUnit &unit : skippedUnits) {
+        std::cout << formatSkipped(unit) << std::endl;
       }
-      std::cout << ");" << std::endl;
     }
     std::cout << "Done processing." << std::endl;
   }
 
+  // Structured output of a shard, one tab-separated record per line:
+  //   global|variable|function <TAB> name <TAB> fingerprint <TAB> report line
+  //   kill <TAB> name            (assigned anywhere in this shard)
+  //   skipped <TAB> report line
+  // Globals are reported without cross-shard kills and candidates without
+  // the baseline; ShardMerger applies both.
+  void emit(std::ostream &out) {
+    for (const std::shared_ptr<DeclData> &decl : globConInfo) {
+      out << "global\t" << decl->name->ToString() << "\t"
+          << formatFingerprint(declFingerprint("global", decl)) << "\t"
+          << formatDecl(scopeOf(decl.get()).filename, decl) << "\n";
+    }
+    for (const std::shared_ptr<DeclData> &decl : varConInfo) {
+      out << "variable\t" << decl->name->ToString() << "\t"
+          << formatFingerprint(declFingerprint("variable", decl)) << "\t"
+          << formatDecl(scopeOf(decl.get()).filename, decl) << "\n";
+    }
+    for (const std::shared_ptr<FunctionData> &func : funConInfo) {
+      out << "function\t" << func->name->ToString() << "\t"
+          << formatFingerprint(functionFingerprint(func)) << "\t"
+          << formatFunction(scopeOf(func.get()).filename, func) << "\n";
+    }
+    for (const std::string &name : globalKills) {
+      out << "kill\t" << name << "\n";
+    }
+    for (const SkippedUnit &unit : skippedUnits) {
+      out << "skipped\t" << formatSkipped(unit) << "\n";
+    }
+  }
+
+  // Only keep units whose file path hashes to index modulo count. Must be
+  // set before parsing; other units are dropped as they are notified.
+  void setShard(std::size_t index, std::size_t count) {
+    shardIndex = index;
+    shardCount = count;
+  }
+
   void ConstInClass(std::shared_ptr<ClassData> data) {
     if (!data) {
       return;
     }
 
-    std::vector<std::shared_ptr<DeclData>> localDataInfo;
+    classScope = join(data->namespaces) +
+                 (data->name ? data->name->ToString() : std::string());
+
+    std::pmr::vector<std::shared_ptr<DeclData>> localDataInfo(&arena);
     for (int p = 0; p < 3; p++) {
       for (unsigned int j = 0; j < data->fields[p].size(); ++j) {
         std::shared_ptr<DeclData> decl = data->fields[p][j];
@@ -343,13 +677,15 @@ public:
     }
     for (auto &decl : localDataInfo) {
       varConInfo.push_back(decl);
+      candidateScopes[decl.get()] = {data->filename, classScope};
       // std::cout << *(decl->name) << std::endl;
     }
   }
 
+  // DeclList is a std::vector or std::pmr::vector of DeclData
+  template <typename DeclList>
   void ConstInFunction(std::shared_ptr<FunctionData> data,
-                       std::vector<std::shared_ptr<DeclData>> &memberDataInfo,
-                       bool isMemberFunction) {
+                       DeclList &memberDataInfo, bool isMemberFunction) {
 
     // std::cout << memberDataInfo.size() << std::endl;
     if (data->isConst || data->isConstExpr) {
@@ -368,10 +704,17 @@ public:
 
     bool modifiesVariable = false;
 
-    BodyLinearizer linearizer;
+    ++budget.functions;
+    // Scratch of this function is bump allocated, first from the stack, and
+    // handed back to the unit arena as a whole when the function is done
+    std::byte buffer[4096];
+    AnalysisBudget::Hold held(budget, sizeof(buffer));
+    std::pmr::monotonic_buffer_resource scratch(buffer, sizeof(buffer),
+                                                &arena);
+    BodyLinearizer linearizer(&budget, &scratch);
     linearizer.linearizeBody(data->block);
 
-    std::vector<std::shared_ptr<DeclData>> localDataInfo;
+    std::pmr::vector<std::shared_ptr<DeclData>> localDataInfo(&scratch);
     for (std::shared_ptr<DeclData> &local : linearizer.locals) {
       if (!local || !local->name || !local->type) {
         continue;
@@ -388,6 +731,7 @@ public:
       std::shared_ptr<ExpressionData> expr = linearizer.expr_stmts[pos];
       if (!expr)
         continue;
+      budget.tick();
 
       std::shared_ptr<NameData> Name;
       std::shared_ptr<OperatorData> Operators;
@@ -396,30 +740,30 @@ public:
       bool hasName = false;
       bool hasOperator = false;
       // std::cout << *(expr) << std::endl;
-      for (const auto expr_data : expr->expr) {
-        try {
-          if (!hasName &&
-              typeid(std::shared_ptr<NameData>) == expr_data.type()) {
-            Name = std::any_cast<std::shared_ptr<NameData>>(expr_data);
-            hasName = true;
-            // std::cout << "Name: " << Name->name;
-          } else if (!hasOperator && typeid(std::shared_ptr<OperatorData>) ==
-                                         expr_data.type()) {
-            Operators = std::any_cast<std::shared_ptr<OperatorData>>(expr_data);
-            hasOperator = true;
-            // std::cout << "   Operator: " << Operators->op;
-          } else if (typeid(std::shared_ptr<LiteralData>) == expr_data.type()) {
-            Literal = std::any_cast<std::shared_ptr<LiteralData>>(expr_data);
-            // std::cout << "   Literal: " << Literal->literal;
-          } else if (typeid(std::shared_ptr<CallData>) == expr_data.type()) {
-            Call = std::any_cast<std::shared_ptr<CallData>>(expr_data);
-            // std::cout << "Call: " << Call->name << std::endl;
-          }
-        } catch (const std::exception &e) {
-          std::cerr << "Error: Failed to convert expression to string: "
-                    << e.what() << std::endl;
-          continue;
-        }
+      for (const ExprNode &node : linearizer.exprParts(pos)) {
+        std::visit(
+            [&](const auto &part) {
+              using Part = std::decay_t<decltype(part)>;
+              if constexpr (std::is_same_v<Part, std::shared_ptr<NameData>>) {
+                if (!hasName) {
+                  Name = part;
+                  hasName = true;
+                }
+              } else if constexpr (std::is_same_v<
+                                       Part, std::shared_ptr<OperatorData>>) {
+                if (!hasOperator) {
+                  Operators = part;
+                  hasOperator = true;
+                }
+              } else if constexpr (std::is_same_v<
+                                       Part, std::shared_ptr<LiteralData>>) {
+                Literal = part;
+              } else if constexpr (std::is_same_v<Part,
+                                                  std::shared_ptr<CallData>>) {
+                Call = part;
+              }
+            },
+            node);
       }
 
       // if (Name) {
@@ -436,12 +780,12 @@ public:
       // }
       // std::cout << std::endl;
       if (hasName && hasOperator) {
-        std::vector<std::string> modificationIndicators = {"=", "++", "--"};
         for (const auto &indicator : modificationIndicators) {
           if (Operators->op.find(indicator) != std::string::npos) {
             modifiesVariable = true;
-            std::string leftSide = Name->name;
-            std::vector<int> index;
+            const std::string &leftSide = Name->name;
+            killGlobal(leftSide);
+            std::pmr::vector<int> index(&scratch);
             // std::cout << "Variable " << leftSide << " " << Operators->op << "
             // "
             //           << isMemberFunction << " " << memberDataInfo.size()
@@ -449,9 +793,7 @@ public:
             if (isMemberFunction) {
               for (unsigned int j = 0; j < memberDataInfo.size(); ++j) {
                 std::string memberName = memberDataInfo[j]->name->ToString();
-                if (leftSide == memberName ||
-                    leftSide == ("this->" + memberName) ||
-                    leftSide.find("." + memberName) != std::string::npos) {
+                if (namesMember(leftSide, memberName)) {
                   index.push_back(j);
                   // std::cout << "Variable " << leftSide << " find memberName "
                   //           << memberName << " in function "
@@ -469,18 +811,6 @@ public:
             }
             index.clear();
 
-            for (unsigned int j = 0; j < globConInfo.size(); ++j) {
-              std::string globName = globConInfo[j]->name->ToString();
-              if (leftSide == globName) {
-                index.push_back(j);
-                continue;
-              }
-            }
-            for (int i = index.size() - 1; i >= 0; --i) {
-              globConInfo.erase(globConInfo.begin() + index[i]);
-            }
-            index.clear();
-
             for (unsigned int j = 0; j < localDataInfo.size(); ++j) {
               std::string localName = localDataInfo[j]->name->ToString();
               if (leftSide == localName) {
@@ -497,13 +827,63 @@ public:
       }
     }
 
+    // Parameter types keep the locals of overloads apart
+    std::string scope =
+        (isMemberFunction ? classScope + "::" : join(data->namespaces)) +
+        data->name->ToString() + parameterTypes(data);
     for (auto &decl : localDataInfo) {
       varConInfo.push_back(decl);
+      candidateScopes[decl.get()] = {data->filename, scope};
     }
 
     if (!modifiesVariable && isMemberFunction) {
       funConInfo.push_back(data);
+      candidateScopes[data.get()] = {data->filename, classScope};
+    }
+  }
+
+  // Candidates found in the loaded baseline are not printed
+  void loadBaseline(std::istream &in) { readBaseline(in, baseline); }
+
+  void writeBaseline(std::ostream &out) {
+    std::set<std::uint64_t> prints;
+    for (const std::shared_ptr<DeclData> &decl : globConInfo) {
+      prints.insert(declFingerprint("global", decl));
+    }
+    for (const std::shared_ptr<DeclData> &decl : varConInfo) {
+      prints.insert(declFingerprint("variable", decl));
+    }
+    for (const std::shared_ptr<FunctionData> &func : funConInfo) {
+      prints.insert(functionFingerprint(func));
     }
+    for (std::uint64_t print : prints) {
+      out << formatFingerprint(print) << "\n";
+    }
+  }
+
+  // Absolute paths under root are fingerprinted relative to it, so a
+  // baseline does not depend on where the tree is checked out
+  void setSourceRoot(const std::filesystem::path &root) {
+    sourceRoot = root.lexically_normal();
+  }
+
+  // Fingerprints leave out line numbers so they survive unrelated edits
+  std::uint64_t declFingerprint(const std::string &kind,
+                                const std::shared_ptr<DeclData> &decl) {
+    const CandidateScope &where = scopeOf(decl.get());
+    return fingerprint(kind + "|" + fingerprintPath(where.filename) + "|" +
+                       where.scope + "|" +
+                       decl->name->ToString() + "|" +
+                       normalizeType(decl->type->ToString()));
+  }
+
+  std::uint64_t functionFingerprint(const std::shared_ptr<FunctionData> &func) {
+    const CandidateScope &where = scopeOf(func.get());
+    return fingerprint("function|" + fingerprintPath(where.filename) + "|" +
+                       where.scope + "|" +
+                       func->name->ToString() + "|" +
+                       normalizeType(func->returnType->ToString()) +
+                       parameterTypes(func));
   }
 
   std::vector<std::shared_ptr<ClassData>> getClassInfo() { return classInfo; }
@@ -518,8 +898,352 @@ public:
     return funConInfo;
   }
   std::string getFileName() { return fileName; }
+  std::set<std::string> getGlobalKills() { return globalKills; }
+  std::size_t getDuplicateCount() { return duplicateCount; }
+  std::vector<SkippedUnit> getSkippedUnits() { return skippedUnits; }
 
 private:
+  bool ownsUnit(const std::string &filename) {
+    return shardCount <= 1 || fingerprint(filename) % shardCount == shardIndex;
+  }
+
+  static std::string formatDecl(const std::string &filename,
+                                const std::shared_ptr<DeclData> &decl) {
+    std::ostringstream line;
+    line << filename << ":" << decl->lineNumber << ":"
+         << decl->type->ToString() << " " << decl->name->ToString() << " = "
+         << *(decl->init) << ";";
+    return line.str();
+  }
+
+  static std::string formatFunction(const std::string &filename,
+                                    const std::shared_ptr<FunctionData> &func) {
+    std::ostringstream line;
+    line << filename << ":" << func->lineNumber << ":"
+         << func->returnType->ToString() << " " << func->name->ToString()
+         << "(";
+    for (std::size_t pos = 0; pos < func->parameters.size(); ++pos) {
+      if (pos > 0) {
+        line << ", ";
+      }
+      line << func->parameters[pos]->type->ToString() << " "
+           << func->parameters[pos]->name->ToString();
+    }
+    line << ");";
+    return line.str();
+  }
+
+  static std::string formatSkipped(const SkippedUnit &unit) {
+    std::ostringstream line;
+    line << unit.filename << ": " << unit.reason << " after " << unit.elapsedMs
+         << " ms, " << unit.peakBytes << " bytes, " << unit.functions
+         << " functions";
+    return line.str();
+  }
+
+  struct CandidateScope {
+    std::string filename;
+    std::string scope;
+  };
+
+  // Globals are collected before any unit is processed and have no scope
+  CandidateScope scopeOf(const void *candidate) {
+    auto it = candidateScopes.find(candidate);
+    if (it == candidateScopes.end()) {
+      return {fileName, ""};
+    }
+    return it->second;
+  }
+
+  // src/a.cpp, ./src/a.cpp and <sourceRoot>/src/a.cpp are the same file
+  std::string fingerprintPath(const std::string &filename) {
+    std::filesystem::path path =
+        std::filesystem::path(filename).lexically_normal();
+    if (path.is_absolute() && !sourceRoot.empty()) {
+      std::filesystem::path relative = path.lexically_relative(sourceRoot);
+      if (!relative.empty() && *relative.begin() != "..") {
+        path = relative;
+      }
+    }
+    return path.generic_string();
+  }
+
+  // leftSide is memberName, this->memberName or contains .memberName
+  static bool namesMember(const std::string &leftSide,
+                          const std::string &memberName) {
+    if (leftSide == memberName) {
+      return true;
+    }
+    if (leftSide.size() == memberName.size() + 6 &&
+        leftSide.compare(0, 6, "this->") == 0 &&
+        leftSide.compare(6, std::string::npos, memberName) == 0) {
+      return true;
+    }
+    for (std::size_t pos = leftSide.find(memberName, 1);
+         pos != std::string::npos; pos = leftSide.find(memberName, pos + 1)) {
+      if (leftSide[pos - 1] == '.') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // "(type,type)" with each type normalized
+  static std::string parameterTypes(const std::shared_ptr<FunctionData> &func) {
+    std::string types = "(";
+    for (std::size_t pos = 0; pos < func->parameters.size(); ++pos) {
+      if (pos > 0) {
+        types += ",";
+      }
+      types += normalizeType(func->parameters[pos]->type->ToString());
+    }
+    return types + ")";
+  }
+
+  static std::string normalizeType(const std::string &type) {
+    std::string normalized;
+    for (char c : type) {
+      if (!std::isspace(static_cast<unsigned char>(c))) {
+        normalized += c;
+      }
+    }
+    return normalized;
+  }
+
+  static constexpr std::string_view modificationIndicators[] = {"=", "++",
+                                                               "--"};
+
+  // leftSide is assigned somewhere, so no global of that name stays const
+  void killGlobal(const std::string &leftSide) {
+    globalKills.insert(leftSide);
+    globConInfo.erase(
+        std::remove_if(globConInfo.begin(), globConInfo.end(),
+                       [&](const std::shared_ptr<DeclData> &decl) {
+                         return decl->name->ToString() == leftSide;
+                       }),
+        globConInfo.end());
+  }
+
+  bool suppressed(std::uint64_t print) {
+    if (baseline.count(print) == 0) {
+      return false;
+    }
+    ++suppressedCount;
+    return true;
+  }
+
+  struct UnitWork {
+    std::string filename;
+    std::vector<std::shared_ptr<ClassData>> classes;
+    std::vector<std::shared_ptr<FunctionData>> functions;
+  };
+
+  // Classes and functions grouped by filename, in order of appearance
+  std::vector<UnitWork> groupByUnit() {
+    std::vector<UnitWork> units;
+    std::unordered_map<std::string, std::size_t> position;
+    auto unitFor = [&](const std::string &filename) -> UnitWork & {
+      auto [it, inserted] = position.try_emplace(filename, units.size());
+      if (inserted) {
+        units.push_back({filename, {}, {}});
+      }
+      return units[it->second];
+    };
+    for (const std::shared_ptr<ClassData> &data : classInfo) {
+      unitFor(data->filename).classes.push_back(data);
+    }
+    for (const std::shared_ptr<FunctionData> &data : functionInfo) {
+      unitFor(data->filename).functions.push_back(data);
+    }
+    return units;
+  }
+
+  // Analyzes one unit within the budget. A unit over budget is abandoned:
+  // its candidates are dropped and it is reported as skipped. Its
+  // assignments still kill globals.
+  void processUnit(const UnitWork &unit) {
+    std::size_t varMark = varConInfo.size();
+    std::size_t funMark = funConInfo.size();
+    budget.startUnit();
+    try {
+      for (std::shared_ptr<ClassData> classData : unit.classes) {
+        assignFileName(classData->filename);
+        if (!inDiffScope(classData->filename, classData->lineNumber))
+          continue;
+        ConstInClass(classData);
+      }
+
+      for (std::shared_ptr<FunctionData> funcData : unit.functions) {
+        assignFileName(funcData->filename);
+        if (!inDiffScope(funcData->filename, funcData->lineNumber))
+          continue;
+        std::pmr::vector<std::shared_ptr<DeclData>> empty(&arena);
+        // std::cout << *(funcData->name) << std::endl;
+        ConstInFunction(funcData, empty, false);
+      }
+    } catch (const BudgetExceeded &e) {
+      varConInfo.resize(varMark);
+      funConInfo.resize(funMark);
+      skippedUnits.push_back({unit.filename, e.what(), budget.elapsedMs(),
+                              budget.peakBytes, budget.functions});
+      scanKills(unit);
+    }
+    // All scratch data of the unit is dead by now; hand it back in one step
+    arena.release();
+  }
+
+  // Assignments anywhere in a unit, found without a budget and without
+  // recursion so that it gets through a unit that went over budget. A
+  // skipped unit drops its own candidates, but the globals it assigns must
+  // still be dropped everywhere else.
+  void scanKills(const UnitWork &unit) {
+    std::vector<std::shared_ptr<BlockData>> pending;
+    for (const std::shared_ptr<ClassData> &classData : unit.classes) {
+      for (int p = 0; p < 3; p++) {
+        for (const std::shared_ptr<FunctionData> &method :
+             classData->methods[p]) {
+          pending.push_back(method->block);
+        }
+      }
+    }
+    for (const std::shared_ptr<FunctionData> &funcData : unit.functions) {
+      pending.push_back(funcData->block);
+    }
+
+    while (!pending.empty()) {
+      std::shared_ptr<BlockData> body = pending.back();
+      pending.pop_back();
+      if (!body)
+        continue;
+      for (const std::shared_ptr<ExpressionData> &expr : body->expr_stmts) {
+        if (!expr)
+          continue;
+        std::shared_ptr<NameData> name;
+        std::shared_ptr<OperatorData> op;
+        for (const std::any &part : expr->expr) {
+          ExprNode node;
+          if (!fromAny(part, node))
+            continue;
+          if (auto *found = std::get_if<std::shared_ptr<NameData>>(&node);
+              found && !name) {
+            name = *found;
+          } else if (auto *found =
+                         std::get_if<std::shared_ptr<OperatorData>>(&node);
+                     found && !op) {
+            op = *found;
+          }
+        }
+        if (!name || !op)
+          continue;
+        for (const auto &indicator : modificationIndicators) {
+          if (op->op.find(indicator) != std::string::npos) {
+            killGlobal(name->name);
+          }
+        }
+      }
+      for (const std::any &conditional : body->conditionals) {
+        ConditionalNode node;
+        if (fromAny(conditional, node)) {
+          std::visit([&](const auto &data) { nestedBlocks(data, pending); },
+                     node);
+        }
+      }
+      for (const std::shared_ptr<BlockData> &block : body->blocks) {
+        pending.push_back(block);
+      }
+    }
+  }
+
+  static void nestedBlocks(const std::shared_ptr<IfStmtData> &if_stmt,
+                           std::vector<std::shared_ptr<BlockData>> &pending) {
+    for (const std::any &clause : if_stmt->clauses) {
+      ClauseNode node;
+      if (fromAny(clause, node)) {
+        std::visit([&](const auto &data) { pending.push_back(data->block); },
+                   node);
+      }
+    }
+  }
+
+  template <typename Conditional>
+  static void nestedBlocks(const std::shared_ptr<Conditional> &data,
+                           std::vector<std::shared_ptr<BlockData>> &pending) {
+    pending.push_back(data->block);
+  }
+
+  // srcDispatch only records where a definition starts, so a definition is
+  // taken to extend up to the next class or function in the same file
+  bool inDiffScope(const std::string &filename, unsigned int lineNumber) {
+    if (!diffScope) {
+      return true;
+    }
+    if (definitionStarts.empty()) {
+      for (const std::shared_ptr<ClassData> &data : classInfo) {
+        definitionStarts[data->filename].insert(data->lineNumber);
+      }
+      for (const std::shared_ptr<FunctionData> &data : functionInfo) {
+        definitionStarts[data->filename].insert(data->lineNumber);
+      }
+    }
+    const std::set<unsigned int> &starts = definitionStarts[filename];
+    auto next = starts.upper_bound(lineNumber);
+    unsigned int last = next == starts.end() ? UINT_MAX : *next - 1;
+    return diffScope->overlaps(filename, lineNumber, last);
+  }
+
+  // Registers a class/function by filename and a hash of its subtree.
+  // Returns false if an identical one was already collected.
+  bool firstSeen(const std::string &filename, const std::string &subtree) {
+    std::string key = filename + ":" + std::to_string(fingerprint(subtree));
+    if (analyzed.insert(key).second) {
+      return true;
+    }
+    ++duplicateCount;
+    return false;
+  }
+
+  std::string declSubtree(const std::shared_ptr<DeclData> &decl) {
+    if (!decl) {
+      return "";
+    }
+    std::ostringstream subtree;
+    subtree << decl->lineNumber << " " << *decl;
+    return subtree.str();
+  }
+
+  std::string functionSubtree(const std::shared_ptr<FunctionData> &data) {
+    if (!data) {
+      return "";
+    }
+    return std::to_string(data->lineNumber) + " " + data->ToString();
+  }
+
+  // Structural text of a class: position, name, fields and method signatures
+  std::string classSubtree(const std::shared_ptr<ClassData> &data) {
+    if (!data) {
+      return "";
+    }
+    std::ostringstream subtree;
+    subtree << data->lineNumber << " " << join(data->namespaces);
+    if (data->name) {
+      subtree << data->name->ToString();
+    }
+    for (int p = 0; p < 3; p++) {
+      for (const std::shared_ptr<DeclData> &decl : data->fields[p]) {
+        if (decl) {
+          subtree << ";" << p << ":" << *decl;
+        }
+      }
+      for (const std::shared_ptr<FunctionData> &method : data->methods[p]) {
+        subtree << ";" << p << ":" << functionSubtree(method);
+      }
+      for (const std::shared_ptr<FunctionData> &op : data->operators[p]) {
+        subtree << ";" << p << ":" << functionSubtree(op);
+      }
+    }
+    return subtree.str();
+  }
+
   std::vector<std::shared_ptr<ClassData>> classInfo;
   std::vector<std::shared_ptr<FunctionData>> functionInfo;
   std::vector<std::shared_ptr<DeclData>> declInfo;
@@ -527,6 +1251,134 @@ private:
   std::vector<std::shared_ptr<DeclData>> varConInfo;
   std::vector<std::shared_ptr<FunctionData>> funConInfo;
   std::string fileName;
+  std::unordered_set<std::string> analyzed;
+  std::size_t duplicateCount = 0;
+  std::optional<DiffScope> diffScope;
+  std::map<std::string, std::set<unsigned int>> definitionStarts;
+  AnalysisBudget budget;
+  std::vector<SkippedUnit> skippedUnits;
+  std::string classScope;
+  std::unordered_map<const void *, CandidateScope> candidateScopes;
+  std::unordered_set<std::uint64_t> baseline;
+  std::filesystem::path sourceRoot;
+  std::size_t suppressedCount = 0;
+  std::set<std::string> globalKills;
+  std::size_t shardIndex = 0;
+  std::size_t shardCount = 1;
+  // Per-unit scratch memory. Blocks freed by one function are reused by the
+  // next, and everything is released in one step after each unit. Small
+  // chunks keep the pool close to what is live; blocks over 256 bytes go
+  // straight to the budgeted upstream.
+  BudgetedResource arenaUpstream{budget};
+  std::pmr::unsynchronized_pool_resource arena{std::pmr::pool_options{4, 256},
+                                               &arenaUpstream};
+};
+
+// Combines the emit() output of several shards into one report. A global
+// candidate assigned in any shard is dropped, as processConst would have
+// done had all units been analyzed in one process. The baseline is applied
+// after that, so the report and its suppressed count match a single run.
+// Each section is sorted so the report does not depend on the order the
+// shards are added in.
+struct ShardMerger {
+  struct Candidate {
+    std::string name;
+    std::uint64_t print;
+    std::string report;
+  };
+
+  std::vector<Candidate> globals;
+  std::vector<Candidate> variables;
+  std::vector<Candidate> functions;
+  std::vector<std::string> skipped;
+  std::set<std::string> kills;
+  std::unordered_set<std::uint64_t> baseline;
+
+  void loadBaseline(std::istream &in) { readBaseline(in, baseline); }
+
+  void add(std::istream &in) {
+    std::string line;
+    while (std::getline(in, line)) {
+      std::size_t first = line.find('\t');
+      if (first == std::string::npos)
+        continue;
+      std::string kind = line.substr(0, first);
+      if (kind == "kill") {
+        kills.insert(line.substr(first + 1));
+        continue;
+      }
+      if (kind == "skipped") {
+        skipped.push_back(line.substr(first + 1));
+        continue;
+      }
+
+      std::size_t second = line.find('\t', first + 1);
+      std::size_t third =
+          second == std::string::npos ? second : line.find('\t', second + 1);
+      if (third == std::string::npos)
+        continue;
+      Candidate candidate{line.substr(first + 1, second - first - 1), 0,
+                          line.substr(third + 1)};
+      if (!parseFingerprint(line.substr(second + 1, third - second - 1),
+                            candidate.print))
+        continue;
+      if (kind == "global") {
+        globals.push_back(candidate);
+      } else if (kind == "variable") {
+        variables.push_back(candidate);
+      } else if (kind == "function") {
+        functions.push_back(candidate);
+      }
+    }
+  }
+
+  void print(std::ostream &out) {
+    auto byReport = [](const Candidate &a, const Candidate &b) {
+      return a.report < b.report;
+    };
+    std::sort(globals.begin(), globals.end(), byReport);
+    std::sort(variables.begin(), variables.end(), byReport);
+    std::sort(functions.begin(), functions.end(), byReport);
+    std::sort(skipped.begin(), skipped.end());
+
+    std::size_t suppressedCount = 0;
+    auto reported = [&](const Candidate &candidate) {
+      if (baseline.count(candidate.print) == 0) {
+        return true;
+      }
+      ++suppressedCount;
+      return false;
+    };
+    out << "Variable const candidates:" << std::endl;
+    out << "Global variable const candidates:" << std::endl;
+    for (const Candidate &candidate : globals) {
+      if (kills.count(candidate.name) == 0 && reported(candidate)) {
+        out << candidate.report << std::endl;
+      }
+    }
+    out << "\nFunction variable const candidates:" << std::endl;
+    for (const Candidate &candidate : variables) {
+      if (reported(candidate)) {
+        out << candidate.report << std::endl;
+      }
+    }
+    out << "\nFunction const candidates:" << std::endl;
+    for (const Candidate &candidate : functions) {
+      if (reported(candidate)) {
+        out << candidate.report << std::endl;
+      }
+    }
+    if (!baseline.empty()) {
+      out << "\nSuppressed by baseline: " << suppressedCount << std::endl;
+    }
+    if (!skipped.empty()) {
+      out << "\nSkipped units:" << std::endl;
+      for (const std::string &report : skipped) {
+        out << report << std::endl;
+      }
+    }
+    out << "Done processing." << std::endl;
+  }
 };
 
 #endif
@@ -0,0 +1,305 @@
+#include <srcDispatchUtilities.hpp>
+#include <srcDispatcherSingleEvent.hpp>
+#include <srcSAXController.hpp>
+
+#include <ClassPolicySingleEvent.hpp>
+#include <DeclTypePolicySingleEvent.hpp>
+#include <FunctionPolicySingleEvent.hpp>
+#include <UnitPolicySingleEvent.hpp>
+
+#include <DoPolicySingleEvent.hpp>
+#include <ForPolicySingleEvent.hpp>
+#include <IfStmtPolicySingleEvent.hpp>
+#include <SwitchPolicySingleEvent.hpp>
+#include <WhilePolicySingleEvent.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <find_const.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <new>
+#include <sstream>
+
+/* Counting allocator hook. Every global operator new/delete in this test
+binary goes through here, including the aligned forms that
+std::pmr::new_delete_resource() (the collector's arena upstream) calls.
+Each block carries its size in a header so live bytes can be tracked on
+delete. Counting is only on between start() and stop(). */
+struct AllocationCounter {
+  bool enabled = false;
+  std::size_t allocations = 0;
+  std::size_t liveBytes = 0;
+  std::size_t peakBytes = 0;
+
+  void start() {
+    allocations = 0;
+    liveBytes = 0;
+    peakBytes = 0;
+    enabled = true;
+  }
+  void stop() { enabled = false; }
+};
+
+AllocationCounter counter;
+
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+void *countedAlloc(std::size_t size,
+                   std::size_t alignment = alignof(std::max_align_t)) {
+  // The header is padded to the alignment so the block stays aligned
+  std::size_t header = std::max(kHeader, alignment);
+  char *block =
+      static_cast<char *>(std::aligned_alloc(header, (size + 2 * header - 1) /
+                                                         header * header));
+  if (!block)
+    throw std::bad_alloc();
+  block += header;
+  reinterpret_cast<std::size_t *>(block)[-1] = counter.enabled ? size : 0;
+  reinterpret_cast<std::size_t *>(block)[-2] = header;
+  if (counter.enabled) {
+    ++counter.allocations;
+    counter.liveBytes += size;
+    counter.peakBytes = std::max(counter.peakBytes, counter.liveBytes);
+  }
+  return block;
+}
+
+void countedFree(void *ptr) {
+  if (!ptr)
+    return;
+  std::size_t size = static_cast<std::size_t *>(ptr)[-1];
+  std::size_t header = static_cast<std::size_t *>(ptr)[-2];
+  counter.liveBytes -= std::min(counter.liveBytes, size);
+  std::free(static_cast<char *>(ptr) - header);
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { countedFree(ptr); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return countedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  countedFree(ptr);
+}
+
+/* Upper bounds: a reference value plus about 25%. A decl or expression
+statement is one node of the generated input.
+
+The reference values were NOT taken from this test. They come from a
+stand-in run that fed the collector hand-built ClassData/FunctionData/
+DeclData for the same generated unit, without srcSAX or srcDispatch. Real
+srcDispatch data (NameData/TypeData::ToString, expression layout) may
+allocate differently. Each test records its measured value as a test
+property ("perNode"); recalibrate the constants from the first
+memory_runner run against the real parser, and again with any change
+that moves them. */
+// Stand-in: 1132 allocations for 3075 nodes, 36.8 per 100 nodes
+constexpr std::size_t kMaxAnalysisAllocationsPer100Nodes = 46;
+// Stand-in: 148800 peak bytes for 3075 nodes, 48.4 per node
+constexpr std::size_t kMaxAnalysisPeakBytesPerNode = 60;
+// Peak of parse plus analysis, over the peak of a parse that only keeps the
+// data. Stand-in: 165428 bytes for 3075 nodes, 53.8 per node.
+constexpr std::size_t kMaxCollectorOverheadBytesPerNode = 67;
+
+constexpr int kFunctions = 200;
+constexpr int kStatements = 10;
+constexpr int kFields = 50;
+
+std::string at(int line) {
+  return " pos:start=\"" + std::to_string(line) + ":1\" pos:end=\"" +
+         std::to_string(line) + ":80\"";
+}
+
+std::string declStmt(int line, const std::string &name, int value) {
+  return "<decl_stmt" + at(line) + "><decl" + at(line) + "><type" + at(line) +
+         "><name" + at(line) + ">int</name></type> <name" + at(line) + ">" +
+         name + "</name> <init" + at(line) + ">= <expr" + at(line) +
+         "><literal type=\"number\"" + at(line) + ">" + std::to_string(value) +
+         "</literal></expr></init></decl>;</decl_stmt>\n";
+}
+
+std::string exprStmt(int line, const std::string &name) {
+  return "<expr_stmt" + at(line) + "><expr" + at(line) + "><name" + at(line) +
+         ">" + name + "</name> <operator" + at(line) +
+         ">=</operator> <literal type=\"number\"" + at(line) +
+         ">1</literal></expr>;</expr_stmt>\n";
+}
+
+std::string function(int &line, const std::string &name, int statements,
+                     const std::string &member) {
+  int first = line++;
+  std::string body;
+  for (int i = 0; i < statements; ++i) {
+    body += declStmt(line++, "v" + std::to_string(i), i);
+  }
+  // Every other local is reassigned, the rest stay const candidates
+  for (int i = 0; i < statements; i += 2) {
+    body += exprStmt(line++, "v" + std::to_string(i));
+  }
+  if (!member.empty()) {
+    body += exprStmt(line++, member);
+  }
+  line++;
+  return "<function" + at(first) + "><type" + at(first) + "><name" +
+         at(first) + ">void</name></type> <name" + at(first) + ">" + name +
+         "</name><parameter_list" + at(first) +
+         ">()</parameter_list> <block" + at(first) + ">{<block_content" +
+         at(first) + ">\n" + body + "</block_content>}</block></function>\n";
+}
+
+// One srcML unit with a class of kFields fields and methods plus kFunctions
+// free functions, each kStatements decls and kStatements / 2 assignments
+std::string generateUnit(const std::string &filename, std::size_t &nodes) {
+  int line = 1;
+  std::string unit =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+      "<unit xmlns=\"http://www.srcML.org/srcML/src\" "
+      "xmlns:cpp=\"http://www.srcML.org/srcML/cpp\" "
+      "xmlns:pos=\"http://www.srcML.org/srcML/position\" revision=\"1.0.0\" "
+      "language=\"C++\" filename=\"" +
+      filename + "\" pos:tabs=\"8\">";
+
+  int classLine = line++;
+  std::string fields;
+  for (int i = 0; i < kFields; ++i) {
+    fields += declStmt(line++, "field" + std::to_string(i), i);
+  }
+  int publicLine = line++;
+  std::string methods;
+  for (int i = 0; i < kFields; i += 2) {
+    methods += function(line, "set" + std::to_string(i), 0,
+                        "field" + std::to_string(i));
+  }
+  unit += "<class" + at(classLine) + ">class <name" + at(classLine) +
+          ">Generated</name> <block" + at(classLine) +
+          ">{<private type=\"default\"" + at(classLine) + ">\n" + fields +
+          "</private><public" + at(publicLine) + ">public:\n" + methods +
+          "</public>}</block>;</class>\n";
+  nodes += kFields + kFields / 2;
+  line++;
+
+  for (int i = 0; i < kFunctions; ++i) {
+    unit += function(line, "f" + std::to_string(i), kStatements, "");
+    nodes += kStatements + (kStatements + 1) / 2;
+  }
+  return unit + "</unit>\n";
+}
+
+// Keeps what the collector keeps and does nothing else; the baseline the
+// collector's own memory is measured against
+class RetainingListener : public srcDispatch::PolicyListener {
+public:
+  void Notify(const srcDispatch::PolicyDispatcher *policy,
+              const srcDispatch::srcSAXEventContext &ctx) override {
+    if (typeid(ClassPolicy) == typeid(*policy)) {
+      classes.push_back(policy->Data<ClassData>());
+    } else if (typeid(FunctionPolicy) == typeid(*policy)) {
+      functions.push_back(policy->Data<FunctionData>());
+    } else if (typeid(DeclTypePolicy) == typeid(*policy)) {
+      decls.push_back(policy->Data<std::vector<std::shared_ptr<DeclData>>>());
+    }
+  }
+
+  void NotifyWrite(const srcDispatch::PolicyDispatcher *policy,
+                   srcDispatch::srcSAXEventContext &ctx) override {}
+
+private:
+  std::vector<std::shared_ptr<ClassData>> classes;
+  std::vector<std::shared_ptr<FunctionData>> functions;
+  std::vector<std::shared_ptr<std::vector<std::shared_ptr<DeclData>>>> decls;
+};
+
+class MemoryTestSuite : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = std::filesystem::temp_directory_path() / "find_const_memory.xml";
+    std::ofstream out(path);
+    out << generateUnit("generated.cpp", nodes);
+  }
+
+  void TearDown() override { std::filesystem::remove(path); }
+
+  void parse(srcDispatch::PolicyListener &result) {
+    srcSAXController control(path.string().c_str());
+    srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&result);
+    control.parse(&dispatch);
+  }
+
+  std::filesystem::path path;
+  std::size_t nodes = 0;
+};
+
+TEST_F(MemoryTestSuite, AnalysisAllocationsPerNode) {
+  collector result;
+  parse(result);
+
+  counter.start();
+  result.processConst();
+  counter.stop();
+
+  EXPECT_GT(result.getVarConInfo().size(), 0);
+  RecordProperty("perNode", std::to_string(100.0 * counter.allocations /
+                                           nodes) +
+                                " allocations per 100 nodes");
+  EXPECT_LE(counter.allocations * 100,
+            kMaxAnalysisAllocationsPer100Nodes * nodes)
+      << counter.allocations << " allocations for " << nodes << " nodes";
+}
+
+TEST_F(MemoryTestSuite, AnalysisPeakBytesPerNode) {
+  collector result;
+  parse(result);
+
+  counter.start();
+  result.processConst();
+  counter.stop();
+
+  RecordProperty("perNode",
+                 std::to_string(double(counter.peakBytes) / nodes) + " bytes");
+  EXPECT_LE(counter.peakBytes, kMaxAnalysisPeakBytesPerNode * nodes)
+      << counter.peakBytes << " peak bytes for " << nodes << " nodes";
+}
+
+TEST_F(MemoryTestSuite, CollectorOverheadPerNode) {
+  counter.start();
+  {
+    RetainingListener retained;
+    parse(retained);
+  }
+  counter.stop();
+  std::size_t parsePeak = counter.peakBytes;
+
+  counter.start();
+  {
+    collector result;
+    parse(result);
+    result.processConst();
+  }
+  counter.stop();
+
+  RecordProperty("perNode",
+                 std::to_string(
+                     (double(counter.peakBytes) - double(parsePeak)) / nodes) +
+                     " bytes");
+  EXPECT_LE(counter.peakBytes,
+            parsePeak + kMaxCollectorOverheadBytesPerNode * nodes)
+      << counter.peakBytes << " peak bytes against " << parsePeak
+      << " for the parse alone, " << nodes << " nodes";
+}
@@ -0,0 +1,125 @@
+# Usage: cmake -DFIND_CONST=<exe> -DARCHIVE=<archive.xml> -DWORK_DIR=<dir>
+#              -DSHARDS=<N> -P shard_merge.cmake
+#
+# Every shard is its own find_const process, as on separate CI runners.
+
+cmake_minimum_required(VERSION 3.14)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+execute_process(
+    COMMAND ${FIND_CONST} --emit ${WORK_DIR}/unsharded.tsv ${ARCHIVE}
+    OUTPUT_VARIABLE unsharded_report
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "unsharded run failed: ${result}")
+endif()
+
+math(EXPR last "${SHARDS} - 1")
+set(shard_outputs)
+foreach(shard RANGE ${last})
+    execute_process(
+        COMMAND ${FIND_CONST} --shard ${shard}/${SHARDS}
+            --emit ${WORK_DIR}/shard${shard}.tsv ${ARCHIVE}
+        OUTPUT_QUIET
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "shard ${shard} failed: ${result}")
+    endif()
+    list(APPEND shard_outputs ${WORK_DIR}/shard${shard}.tsv)
+endforeach()
+
+# The global declared in one shard must be assigned in another
+set(declaring 0)
+set(killing 0)
+foreach(output IN LISTS shard_outputs)
+    file(READ ${output} emitted)
+    string(FIND "${emitted}" "global\tcounter\t" declares)
+    string(FIND "${emitted}" "kill\tcounter\n" kills)
+    if(NOT declares EQUAL -1 AND NOT kills EQUAL -1)
+        message(FATAL_ERROR "counter is declared and assigned in ${output}")
+    endif()
+    if(NOT declares EQUAL -1)
+        math(EXPR declaring "${declaring} + 1")
+    endif()
+    if(NOT kills EQUAL -1)
+        math(EXPR killing "${killing} + 1")
+    endif()
+endforeach()
+if(NOT declaring EQUAL 1 OR NOT killing EQUAL 1)
+    message(FATAL_ERROR
+        "expected counter declared in one shard and assigned in another")
+endif()
+
+execute_process(
+    COMMAND ${FIND_CONST} --merge ${shard_outputs}
+    OUTPUT_VARIABLE merged
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "merge failed: ${result}")
+endif()
+execute_process(
+    COMMAND ${FIND_CONST} --merge ${WORK_DIR}/unsharded.tsv
+    OUTPUT_VARIABLE expected)
+
+if(NOT merged STREQUAL expected)
+    message(FATAL_ERROR
+        "merged shards differ from unsharded run\n"
+        "merged:\n${merged}\nunsharded:\n${expected}")
+endif()
+
+# The merged report holds the same lines as the unsharded report itself.
+# Report lines end in ';', which is masked before splitting into a list.
+string(REPLACE ";" "<semicolon>" merged_lines "${merged}")
+string(REPLACE ";" "<semicolon>" unsharded_lines "${unsharded_report}")
+string(REPLACE "\n" ";" merged_lines "${merged_lines}")
+string(REPLACE "\n" ";" unsharded_lines "${unsharded_lines}")
+list(SORT merged_lines)
+list(SORT unsharded_lines)
+if(NOT merged_lines STREQUAL unsharded_lines)
+    message(FATAL_ERROR
+        "merged shards differ from unsharded report\n"
+        "merged:\n${merged}\nunsharded:\n${unsharded_report}")
+endif()
+
+string(FIND "${merged}" "counter" counter_reported)
+if(NOT counter_reported EQUAL -1)
+    message(FATAL_ERROR "counter is assigned in main.cpp but was reported")
+endif()
+
+# A baseline given to --merge suppresses the same candidates as in a
+# single run
+execute_process(
+    COMMAND ${FIND_CONST} --write-baseline ${WORK_DIR}/baseline.txt ${ARCHIVE}
+    OUTPUT_QUIET
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "writing the baseline failed: ${result}")
+endif()
+execute_process(
+    COMMAND ${FIND_CONST} --baseline ${WORK_DIR}/baseline.txt ${ARCHIVE}
+    OUTPUT_VARIABLE expected)
+execute_process(
+    COMMAND ${FIND_CONST} --baseline ${WORK_DIR}/baseline.txt
+        --merge ${shard_outputs}
+    OUTPUT_VARIABLE merged
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "merge with a baseline failed: ${result}")
+endif()
+if(NOT merged STREQUAL expected)
+    message(FATAL_ERROR
+        "merged shards with a baseline differ from the single run\n"
+        "merged:\n${merged}\nsingle run:\n${expected}")
+endif()
+
+# Options that only apply to an analysis are rejected by --merge
+execute_process(
+    COMMAND ${FIND_CONST} --shard 0/${SHARDS} --merge ${shard_outputs}
+    OUTPUT_QUIET
+    ERROR_QUIET
+    RESULT_VARIABLE result)
+if(result EQUAL 0)
+    message(FATAL_ERROR "--merge accepted --shard")
+endif()
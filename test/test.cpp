@@ -18,6 +18,7 @@
 #include <fstream>
 #include <gtest/gtest.h>
 #include <sstream>
+#include <thread>
 
 /* The line `std::string filepath = "test/input_file/input.xml";` is declaring a
 variable named `filepath` of type `std::string` and initializing it with the
@@ -135,6 +136,354 @@ TEST_F(MyTestSuite, FunctionVariableConstCandidates) {
   EXPECT_TRUE(foundLocalVar);
 }
 
+TEST_F(MyTestSuite, SharedDefinitionsAnalyzedOnce) {
+  std::size_t classCount = result.getClassInfo().size();
+  std::size_t functionCount = result.getFunctionInfo().size();
+  EXPECT_EQ(result.getDuplicateCount(), 0);
+
+  collector single;
+  {
+    srcSAXController control(filepath.c_str());
+    srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&single);
+    control.parse(&dispatch);
+  }
+  single.processConst();
+
+  // Feeding the same unit again must not add classes, functions or globals
+  srcSAXController control(filepath.c_str());
+  srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&result);
+  control.parse(&dispatch);
+  EXPECT_EQ(result.getClassInfo().size(), classCount);
+  EXPECT_EQ(result.getFunctionInfo().size(), functionCount);
+  EXPECT_GT(result.getDuplicateCount(), classCount + functionCount);
+
+  result.processConst();
+  EXPECT_EQ(result.getGlobConInfo().size(), single.getGlobConInfo().size());
+  std::size_t maxStudentCount = 0;
+  for (const auto &decl : result.getGlobConInfo()) {
+    if (decl->name && decl->name->ToString() == "max_student") {
+      ++maxStudentCount;
+    }
+  }
+  EXPECT_EQ(maxStudentCount, 1);
+
+  std::size_t studentIdCount = 0;
+  for (const auto &decl : result.getVarConInfo()) {
+    if (decl->name && decl->name->ToString() == "studentId") {
+      ++studentIdCount;
+    }
+  }
+  EXPECT_EQ(studentIdCount, 1);
+}
+
+TEST_F(MyTestSuite, DiffScopedAnalysis) {
+  std::istringstream diff("--- a/test/input_file/input.cpp\n"
+                          "+++ b/test/input_file/input.cpp\n"
+                          "@@ -25 +25 @@ public:\n"
+                          "-  void addTax(double tax) { tax_rate = tax; }\n"
+                          "+  void addTax(double tax) { tax_rate += tax; }\n");
+  DiffScope scope;
+  scope.parseUnifiedDiff(diff);
+  EXPECT_TRUE(scope.overlaps("input.cpp", 11, 33));
+  EXPECT_FALSE(scope.overlaps("input.cpp", 34, 48));
+  EXPECT_FALSE(scope.overlaps("other.cpp", 11, 33));
+
+  result.setDiffScope(scope);
+  result.processConst();
+  EXPECT_EQ(result.getGlobConInfo().size(), 0);
+
+  bool foundMember = false;
+  for (const auto &decl : result.getVarConInfo()) {
+    if (decl->name && decl->name->ToString() == "studentId") {
+      foundMember = true;
+    }
+    // main() lies outside the changed lines and is never analyzed
+    EXPECT_NE(decl->name->ToString(), "radius");
+  }
+  EXPECT_TRUE(foundMember);
+}
+
+TEST_F(MyTestSuite, UnitOverBudgetIsSkipped) {
+  result.setBudget(std::chrono::milliseconds(0), 1);
+  result.processConst();
+
+  std::vector<collector::SkippedUnit> skipped = result.getSkippedUnits();
+  ASSERT_EQ(skipped.size(), 1);
+  EXPECT_EQ(skipped[0].filename, testFilename);
+  EXPECT_GT(skipped[0].peakBytes, 1);
+  EXPECT_EQ(result.getVarConInfo().size(), 0);
+  EXPECT_EQ(result.getFunConInfo().size(), 0);
+}
+
+TEST_F(MyTestSuite, UnitWithinBudgetIsAnalyzed) {
+  result.setBudget(std::chrono::milliseconds(60000), 64 * 1024 * 1024);
+  result.processConst();
+  EXPECT_EQ(result.getSkippedUnits().size(), 0);
+  EXPECT_GT(result.getVarConInfo().size(), 0);
+}
+
+TEST_F(MyTestSuite, BaselineSuppressesKnownCandidates) {
+  result.processConst();
+  std::stringstream baseline;
+  result.writeBaseline(baseline);
+  std::size_t candidates = result.getGlobConInfo().size() +
+                           result.getVarConInfo().size() +
+                           result.getFunConInfo().size();
+
+  std::string line;
+  std::size_t lines = 0;
+  while (std::getline(baseline, line)) {
+    EXPECT_EQ(line.size(), 16);
+    ++lines;
+  }
+  EXPECT_EQ(lines, candidates);
+
+  collector rerun;
+  srcSAXController control(filepath.c_str());
+  srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&rerun);
+  control.parse(&dispatch);
+  baseline.clear();
+  baseline.seekg(0);
+  std::stringstream withGarbage;
+  withGarbage << "not-a-fingerprint\n" << baseline.rdbuf();
+  EXPECT_NO_THROW(rerun.loadBaseline(withGarbage));
+
+  testing::internal::CaptureStdout();
+  rerun.printConst();
+  std::string output = testing::internal::GetCapturedStdout();
+  EXPECT_EQ(output.find("studentId"), std::string::npos);
+  EXPECT_EQ(output.find("max_student"), std::string::npos);
+  EXPECT_NE(output.find("Suppressed by baseline: " + std::to_string(lines)),
+            std::string::npos);
+}
+
+// Baseline of input.xml with its unit renamed to unitPath
+std::string baselineAs(const std::string &unitPath,
+                       const std::filesystem::path &root) {
+  std::ifstream in(filepath);
+  std::stringstream text;
+  text << in.rdbuf();
+  std::string xml = text.str();
+  const std::string original = "filename=\"input.cpp\"";
+  xml.replace(xml.find(original), original.size(),
+              "filename=\"" + unitPath + "\"");
+  std::filesystem::path renamed =
+      std::filesystem::temp_directory_path() / "find_const_renamed.xml";
+  {
+    std::ofstream out(renamed);
+    out << xml;
+  }
+
+  collector run;
+  run.setSourceRoot(root);
+  srcSAXController control(renamed.string().c_str());
+  srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&run);
+  control.parse(&dispatch);
+  run.processConst();
+  std::stringstream baseline;
+  run.writeBaseline(baseline);
+  std::filesystem::remove(renamed);
+  return baseline.str();
+}
+
+TEST(BaselineTest, FingerprintsIgnorePathSpelling) {
+  std::filesystem::path root = "/ci/workspace-123";
+  std::string relative = baselineAs("src/input.cpp", root);
+  EXPECT_FALSE(relative.empty());
+  EXPECT_EQ(baselineAs("./src/input.cpp", root), relative);
+  EXPECT_EQ(baselineAs("/ci/workspace-123/src/input.cpp", root), relative);
+}
+
+/* Multi-unit archive next to input.xml: config.cpp, main.cpp and util.cpp
+land in different shards of three, and main.cpp assigns the global counter
+declared in config.cpp. */
+void parseArchive(collector &run) {
+  std::string archive =
+      std::filesystem::path(filepath).replace_filename("archive.xml").string();
+  srcSAXController control(archive.c_str());
+  srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&run);
+  control.parse(&dispatch);
+}
+
+std::string emitShard(std::size_t index, std::size_t count) {
+  collector part;
+  part.setShard(index, count);
+  parseArchive(part);
+  part.processConst();
+  std::stringstream emitted;
+  part.emit(emitted);
+  return emitted.str();
+}
+
+TEST(ShardTest, ShardedRunsMergeToSingleRun) {
+  std::istringstream unsharded(emitShard(0, 1));
+  ShardMerger single;
+  single.add(unsharded);
+  std::ostringstream expected;
+  single.print(expected);
+
+  ShardMerger merger;
+  std::size_t declaringShards = 0;
+  std::size_t killingShards = 0;
+  for (std::size_t shard = 0; shard < 3; ++shard) {
+    std::string emitted = emitShard(shard, 3);
+    bool declares = emitted.find("global\tcounter\t") != std::string::npos;
+    bool kills = emitted.find("kill\tcounter\n") != std::string::npos;
+    // The kill only exists in another shard than the declaration
+    EXPECT_FALSE(declares && kills);
+    declaringShards += declares ? 1 : 0;
+    killingShards += kills ? 1 : 0;
+
+    std::istringstream in(emitted);
+    merger.add(in);
+  }
+  EXPECT_EQ(declaringShards, 1);
+  EXPECT_EQ(killingShards, 1);
+
+  std::ostringstream merged;
+  merger.print(merged);
+  EXPECT_EQ(merged.str(), expected.str());
+  EXPECT_EQ(merged.str().find("counter"), std::string::npos);
+  EXPECT_NE(merged.str().find("limit"), std::string::npos);
+}
+
+TEST(ShardTest, MergeAppliesBaseline) {
+  collector full;
+  parseArchive(full);
+  full.processConst();
+  std::stringstream baseline;
+  full.writeBaseline(baseline);
+  ASSERT_FALSE(baseline.str().empty());
+
+  // Every candidate is in the baseline, so only the summary lines remain
+  collector rerun;
+  parseArchive(rerun);
+  std::istringstream rerunBaseline(baseline.str());
+  rerun.loadBaseline(rerunBaseline);
+  testing::internal::CaptureStdout();
+  rerun.printConst();
+  std::string expected = testing::internal::GetCapturedStdout();
+
+  ShardMerger merger;
+  std::istringstream mergerBaseline(baseline.str());
+  merger.loadBaseline(mergerBaseline);
+  for (std::size_t shard = 0; shard < 3; ++shard) {
+    std::istringstream in(emitShard(shard, 3));
+    merger.add(in);
+  }
+  std::ostringstream merged;
+  merger.print(merged);
+  EXPECT_EQ(merged.str(), expected);
+  EXPECT_NE(merged.str().find("Suppressed by baseline: "), std::string::npos);
+  EXPECT_EQ(merged.str().find("limit"), std::string::npos);
+}
+
+TEST(ShardMergerTest, GlobalAssignedInOtherShardIsDropped) {
+  std::istringstream first(
+      "global\tcount\t00000000000000a1\ta.cpp:1:int count = 0;\n"
+      "global\tlimit\t00000000000000a2\ta.cpp:2:int limit = 5;\n");
+  std::istringstream second("kill\tcount\n");
+  ShardMerger merger;
+  merger.add(first);
+  merger.add(second);
+
+  std::ostringstream merged;
+  merger.print(merged);
+  EXPECT_EQ(merged.str().find("count"), std::string::npos);
+  EXPECT_NE(merged.str().find("a.cpp:2:int limit = 5;"), std::string::npos);
+}
+
+TEST(ShardMergerTest, BaselineSuppressesMergedCandidates) {
+  std::istringstream shard(
+      "global\tlimit\t00000000000000a2\ta.cpp:2:int limit = 5;\n"
+      "variable\tstep\t00000000000000b1\tb.cpp:4:int step = 1;\n"
+      "variable\ttotal\t00000000000000b2\tb.cpp:9:int total = 5;\n");
+  std::istringstream baseline("00000000000000a2\n00000000000000b1\n");
+  ShardMerger merger;
+  merger.loadBaseline(baseline);
+  merger.add(shard);
+
+  std::ostringstream merged;
+  merger.print(merged);
+  EXPECT_EQ(merged.str().find("limit"), std::string::npos);
+  EXPECT_EQ(merged.str().find("step"), std::string::npos);
+  EXPECT_NE(merged.str().find("b.cpp:9:int total = 5;"), std::string::npos);
+  EXPECT_NE(merged.str().find("Suppressed by baseline: 2"), std::string::npos);
+}
+
+TEST(BudgetTest, GlobalAssignedInSkippedUnitIsNotACandidate) {
+  // Every unit of the archive goes over a one-byte budget, main.cpp
+  // included, but its assignment to counter must still count
+  std::string archive =
+      std::filesystem::path(filepath).replace_filename("archive.xml").string();
+  collector limited;
+  limited.setBudget(std::chrono::milliseconds(0), 1);
+  srcSAXController control(archive.c_str());
+  srcDispatch::srcDispatcherSingleEvent<UnitPolicy> dispatch(&limited);
+  control.parse(&dispatch);
+  limited.processConst();
+
+  EXPECT_EQ(limited.getSkippedUnits().size(), 3);
+  bool foundLimit = false;
+  for (const std::shared_ptr<DeclData> &decl : limited.getGlobConInfo()) {
+    EXPECT_NE(decl->name->ToString(), "counter");
+    foundLimit = foundLimit || decl->name->ToString() == "limit";
+  }
+  EXPECT_TRUE(foundLimit);
+
+  std::stringstream emitted;
+  limited.emit(emitted);
+  EXPECT_NE(emitted.str().find("kill\tcounter\n"), std::string::npos);
+}
+
+TEST(BudgetTest, TimeLimitIsSampledEvery256Ticks) {
+  AnalysisBudget budget;
+  budget.timeLimit = std::chrono::milliseconds(1);
+  budget.startUnit();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  for (int tick = 1; tick < 256; ++tick) {
+    ASSERT_NO_THROW(budget.tick()) << "tick " << tick;
+  }
+  EXPECT_THROW(budget.tick(), BudgetExceeded);
+}
+
+TEST(BodyLinearizerTest, LongBodyExceedsTimeBudget) {
+  // One tick per block: enough blocks to reach a clock sample
+  std::shared_ptr<BlockData> root = std::make_shared<BlockData>();
+  for (int block = 0; block < 1024; ++block) {
+    root->blocks.push_back(std::make_shared<BlockData>());
+  }
+
+  AnalysisBudget unlimited;
+  unlimited.startUnit();
+  BodyLinearizer within(&unlimited);
+  EXPECT_NO_THROW(within.linearizeBody(root));
+
+  AnalysisBudget budget;
+  budget.timeLimit = std::chrono::milliseconds(1);
+  budget.startUnit();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  BodyLinearizer beyond(&budget);
+  EXPECT_THROW(beyond.linearizeBody(root), BudgetExceeded);
+}
+
+TEST(BodyLinearizerTest, DeepNestingExceedsBudget) {
+  // A chain of maxDepth nested blocks is linearized, one more is not
+  std::shared_ptr<BlockData> root = std::make_shared<BlockData>();
+  std::shared_ptr<BlockData> block = root;
+  for (std::size_t depth = 1; depth < BodyLinearizer::maxDepth; ++depth) {
+    block->blocks.push_back(std::make_shared<BlockData>());
+    block = block->blocks.back();
+  }
+  BodyLinearizer within;
+  EXPECT_NO_THROW(within.linearizeBody(root));
+
+  block->blocks.push_back(std::make_shared<BlockData>());
+  BodyLinearizer beyond;
+  EXPECT_THROW(beyond.linearizeBody(root), BudgetExceeded);
+}
+
 int main(int argc, char *argv[]) {
   std::filesystem::path currentPath = std::filesystem::current_path();
 